@@ -13,7 +13,17 @@ GRAPH_DIRS = {
     'cycles': f'{GRAPHS_BASE_DIR}/cycles',
     'speed': f'{GRAPHS_BASE_DIR}/speed',
     'speedup': f'{GRAPHS_BASE_DIR}/speedup',
-    'variability': f'{GRAPHS_BASE_DIR}/variability'
+    'variability': f'{GRAPHS_BASE_DIR}/variability',
+    'short': f'{GRAPHS_BASE_DIR}/short',
+    'stages': f'{GRAPHS_BASE_DIR}/stages'
+}
+# Per-stage columns written by an instrumented build (make INSTRUMENT=1)
+STAGE_COLUMNS = {
+    'KeyScheduleCycles': 'Key schedule',
+    'HashHCycles': 'H (7-round)',
+    'HashICycles': 'I (4-round)',
+    'LastBlockCycles': 'Last block XOR',
+    'FinalAesCycles': 'Final AES (10-round)'
 }
 
 # Create directories
@@ -35,11 +45,22 @@ df['MessageLength'] = pd.to_numeric(df['MessageLength'], errors='coerce')
 # Calculate Speed (MB/s) = MessageLength (bytes) / TimeUs (µs) * 1e6 (µs/s) / 1e6 (MB)
 df['SpeedMBps'] = df['MessageLength'] / (df['TimeUs'] * 1e6) * 1e6
 df.dropna(subset=['CyclesPerByte', 'SpeedMBps'], inplace=True)
+if 'Kernel' not in df.columns:
+    df['Kernel'] = 'general'
+df['LatencyCycles'] = df['CyclesPerByte'] * df['MessageLength']
+
+# Short-path comparison rows (short kernel and its general-path baseline, lengths up to 64 bytes)
+short_df = df[df['Kernel'].isin(['short', 'general-short'])].copy()
+short_df['Kernel'] = short_df['Kernel'].replace({'general-short': 'general'})
+# Main analysis: general-path rows of the suite only
+df = df[df['Kernel'] == 'general']
 
 # Map numeric encodings to labels
 encoding_map = {0: 'Naive', 1: 'Compact', 2: 'Custom1', 3: 'Custom2'}
 if df['Encoding'].dtype in ['int64', 'float64']:
     df['Encoding'] = df['Encoding'].map(encoding_map).fillna(df['Encoding'])
+if short_df['Encoding'].dtype in ['int64', 'float64']:
+    short_df = short_df.assign(Encoding=short_df['Encoding'].map(encoding_map).fillna(short_df['Encoding']))
 
 # Set Seaborn style
 sns.set(style="whitegrid", palette="deep", font_scale=1.2, rc={'figure.figsize': (12, 8)})
@@ -167,6 +188,57 @@ if not subset.empty:
     plt.savefig(f'{GRAPH_DIRS["variability"]}/cycles_heatmap_encoding_msglen.png', dpi=300)
     plt.close()
 
+# Table 3 + Graph 7: Latency (cycles per MAC) of the short-message path vs. the general path
+short_subset = short_df[(short_df['Precompute'] == 0) & (short_df['Parallel'] == 0) & (short_df['TagBits'] == 128)]
+if not short_subset.empty and 'short' in short_subset['Kernel'].values:
+    latency = short_subset.groupby(['MessageLength', 'Encoding', 'Kernel'])['LatencyCycles'].mean().unstack('Kernel')
+    with open(f'{TABLES_DIR}/short_latency_table.txt', 'w') as f:
+        f.write("Mean latency (cycles per MAC):\n")
+        if 'general' in latency.columns:
+            latency['Speedup'] = latency['general'] / latency['short']
+        f.write(latency.to_string(float_format="%.2f"))
+    plt.figure()
+    sns.lineplot(data=short_subset, x='MessageLength', y='LatencyCycles', hue='Kernel', style='Encoding', markers=True)
+    plt.yscale('log')
+    plt.title('Latency vs. Message Length: Short Path vs. General Path\n(Precompute=0, Parallel=0, 128-bit Tag, Fixed Keys)')
+    plt.xlabel('Message Length (Bytes)')
+    plt.ylabel('Cycles per MAC (Log Scale)')
+    plt.legend(title='Kernel / Encoding', loc='best')
+    plt.tight_layout()
+    plt.savefig(f'{GRAPH_DIRS["short"]}/short_path_latency.png', dpi=300)
+    plt.close()
+
+# Table 4 + Graph 8: Per-stage cost breakdown (instrumented builds only)
+if all(col in df.columns for col in STAGE_COLUMNS):
+    for col in list(STAGE_COLUMNS) + ['Threads', 'ThreadImbalance']:
+        df[col] = pd.to_numeric(df[col], errors='coerce')
+    stage_df = df.dropna(subset=list(STAGE_COLUMNS))
+    with open(f'{TABLES_DIR}/stage_table.txt', 'w') as f:
+        for precomp in [0, 1]:
+            for par in [0, 1]:
+                subset = stage_df[(stage_df['Precompute'] == precomp) & (stage_df['Parallel'] == par) & (stage_df['TagBits'] == 128)]
+                if subset.empty:
+                    continue
+                # cycles per byte spent in each stage
+                breakdown = subset.groupby('MessageLength')[list(STAGE_COLUMNS)].mean().div(subset.groupby('MessageLength')['MessageLength'].first(), axis=0)
+                breakdown = breakdown.rename(columns=STAGE_COLUMNS)
+                f.write(f"Cycles/Byte per stage (Precompute={precomp}, Parallel={par}, 128-bit Tag):\n")
+                f.write(breakdown.to_string(float_format="%.3f"))
+                f.write("\n\n")
+                ax = breakdown.plot(kind='bar', stacked=True, figsize=(12, 8))
+                ax.set_title(f'Per-Stage Cost Breakdown\n(Precompute={precomp}, Parallel={par}, 128-bit Tag)')
+                ax.set_xlabel('Message Length (Bytes)')
+                ax.set_ylabel('Cycles/Byte')
+                ax.legend(title='Stage', loc='best')
+                plt.tight_layout()
+                plt.savefig(f'{GRAPH_DIRS["stages"]}/stages_precomp_{precomp}_parallel_{par}.png', dpi=300)
+                plt.close()
+        parallel_df = stage_df[stage_df['Parallel'] == 1]
+        if not parallel_df.empty:
+            f.write("Parallel elihash threads and imbalance (busiest thread / mean):\n")
+            f.write(parallel_df.groupby(['MessageLength', 'Precompute'])[['Threads', 'ThreadImbalance']].mean().to_string(float_format="%.2f"))
+            f.write("\n")
+
 # Summary Report
 with open(f'{TABLES_DIR}/analysis_summary.txt', 'w') as f:
     f.write("EliMAC Performance Analysis Summary\n")
@@ -28,28 +28,88 @@ void hash_i(const uint8_t *h_output, const uint8_t *message_block, uint8_t *outp
     aes_encrypt(input, round_keys, output, 4);
 }
 
-void elihash(uint8_t *state, size_t num_blocks, uint8_t *round_keys_7,
-             const uint8_t *subkeys, int precompute, const uint8_t *padded, uint8_t *round_keys_4, int parallel, int variant)
+// One block of H/I folded into acc
+static inline void elihash_block(size_t i, uint8_t *acc, const uint8_t *round_keys_7, const uint8_t *subkeys, int precompute,
+                                 const uint8_t *padded, const uint8_t *round_keys_4, int variant)
 {
+    uint8_t h_output[BLOCK_SIZE], i_output[BLOCK_SIZE];
+    hash_h(i + 1, h_output, round_keys_7, subkeys, precompute, variant);
+    hash_i(h_output, padded + i * BLOCK_SIZE, i_output, round_keys_4);
+    for (int j = 0; j < BLOCK_SIZE; j++)
+    {
+        acc[j] ^= i_output[j];
+    }
+}
+
+#ifdef ELIMAC_INSTRUMENT
+static volatile uint8_t elihash_sample_sink;
+
+// H:I cost ratio for instrument_split(): an H-only and an I-only pass over the
+// first blocks, repeated up to INSTRUMENT_SAMPLE_BLOCKS blocks. Meant to run
+// once per configuration, outside any timed region.
+void elihash_sample(size_t num_blocks, const uint8_t *round_keys_7, const uint8_t *subkeys, int precompute,
+                    const uint8_t *padded, const uint8_t *round_keys_4, int variant, instrument_sample *sample)
+{
+    sample->h = 0;
+    sample->i = 0;
+    if (num_blocks < 2)
+        return;
+    size_t n = num_blocks - 1 < INSTRUMENT_SAMPLE_BLOCKS ? num_blocks - 1 : INSTRUMENT_SAMPLE_BLOCKS;
+    size_t passes = INSTRUMENT_SAMPLE_BLOCKS / n;
+    uint8_t h_output[BLOCK_SIZE] = {0}, i_output[BLOCK_SIZE], acc[BLOCK_SIZE] = {0};
+
+    uint64_t start = instrument_now();
+    for (size_t p = 0; p < passes; p++)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            hash_h(i + 1, h_output, round_keys_7, subkeys, precompute, variant);
+            for (int j = 0; j < BLOCK_SIZE; j++)
+            {
+                acc[j] ^= h_output[j];
+            }
+        }
+    }
+    sample->h = instrument_elapsed(start);
+
+    start = instrument_now();
+    for (size_t p = 0; p < passes; p++)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            hash_i(h_output, padded + i * BLOCK_SIZE, i_output, round_keys_4);
+            for (int j = 0; j < BLOCK_SIZE; j++)
+            {
+                acc[j] ^= i_output[j];
+            }
+        }
+    }
+    sample->i = instrument_elapsed(start);
+
+    elihash_sample_sink ^= acc[0];
+}
+#endif
+
+void elihash(uint8_t *state, size_t num_blocks, const uint8_t *round_keys_7,
+             const uint8_t *subkeys, int precompute, const uint8_t *padded, const uint8_t *round_keys_4, int parallel, int variant)
+{
+    INSTRUMENT_TIMESTAMP(loop_start);
     if (parallel)
     {
 #ifdef _OPENMP
 #pragma omp parallel
         {
             uint8_t local_state[BLOCK_SIZE] = {0};
-#pragma omp for
+            INSTRUMENT_TIMESTAMP(thread_start);
+#pragma omp for nowait
             for (size_t i = 0; i < num_blocks - 1; i++)
             {
-                uint8_t h_output[BLOCK_SIZE], i_output[BLOCK_SIZE];
-                hash_h(i + 1, h_output, round_keys_7, subkeys, precompute, variant);
-                hash_i(h_output, padded + i * BLOCK_SIZE, i_output, round_keys_4);
-                for (int j = 0; j < BLOCK_SIZE; j++)
-                {
-                    local_state[j] ^= i_output[j];
-                }
+                elihash_block(i, local_state, round_keys_7, subkeys, precompute, padded, round_keys_4, variant);
             }
+            INSTRUMENT_ELAPSED(thread_cycles, thread_start);
 #pragma omp critical
             {
+                INSTRUMENT_THREAD_WORK(omp_get_thread_num(), omp_get_num_threads(), thread_cycles);
                 for (int j = 0; j < BLOCK_SIZE; j++)
                 {
                     state[j] ^= local_state[j];
@@ -59,13 +119,7 @@ void elihash(uint8_t *state, size_t num_blocks, uint8_t *round_keys_7,
 #else
         for (size_t i = 0; i < num_blocks - 1; i++)
         {
-            uint8_t h_output[BLOCK_SIZE], i_output[BLOCK_SIZE];
-            hash_h(i + 1, h_output, round_keys_7, subkeys, precompute, variant);
-            hash_i(h_output, padded + i * BLOCK_SIZE, i_output, round_keys_4);
-            for (int j = 0; j < BLOCK_SIZE; j++)
-            {
-                state[j] ^= i_output[j];
-            }
+            elihash_block(i, state, round_keys_7, subkeys, precompute, padded, round_keys_4, variant);
         }
 #endif
     }
@@ -73,12 +127,61 @@ void elihash(uint8_t *state, size_t num_blocks, uint8_t *round_keys_7,
     {
         for (size_t i = 0; i < num_blocks - 1; i++)
         {
-            uint8_t h_output[BLOCK_SIZE], i_output[BLOCK_SIZE];
-            hash_h(i + 1, h_output, round_keys_7, subkeys, precompute, variant);
-            hash_i(h_output, padded + i * BLOCK_SIZE, i_output, round_keys_4);
-            for (int j = 0; j < BLOCK_SIZE; j++)
+            elihash_block(i, state, round_keys_7, subkeys, precompute, padded, round_keys_4, variant);
+        }
+    }
+    // wall time of the whole loop (parallel region included)
+    INSTRUMENT_ELAPSED(loop_cycles, loop_start);
+#ifdef ELIMAC_INSTRUMENT
+    elimac_stats.hash_loop += loop_cycles;
+#ifdef _OPENMP
+    if (!parallel)
+#endif
+        instrument_thread_work(0, 1, loop_cycles);
+#endif
+}
+
+// Same message under many (K1, K2): each block is loaded once and the
+// H/I computations of up to MULTI_LANES keys are interleaved round by round.
+// I uses the first 5 round keys of each 7-round schedule (same key K1).
+void elihash_multi(uint8_t *states, size_t num_keys, size_t num_blocks, const uint8_t *round_keys_7,
+                   const uint8_t *padded, int variant)
+{
+    for (size_t i = 0; i + 1 < num_blocks; i++)
+    {
+        uint8_t counter_bytes[BLOCK_SIZE];
+        encode_counter(i + 1, counter_bytes, variant);
+        __m128i counter = _mm_loadu_si128((const __m128i *)counter_bytes);
+        __m128i block = _mm_loadu_si128((const __m128i *)(padded + i * BLOCK_SIZE));
+
+        for (size_t k0 = 0; k0 < num_keys; k0 += MULTI_LANES)
+        {
+            size_t lanes = (num_keys - k0 < MULTI_LANES) ? num_keys - k0 : MULTI_LANES;
+            const uint8_t *rk7 = round_keys_7 + k0 * KEY_SIZE * 8;
+            __m128i s[MULTI_LANES];
+
+            // 7-round AES-128 of the counter under each K1
+            for (size_t k = 0; k < lanes; k++)
+                s[k] = _mm_xor_si128(counter, _mm_loadu_si128((const __m128i *)(rk7 + k * KEY_SIZE * 8)));
+            for (int r = 1; r < 7; r++)
+                for (size_t k = 0; k < lanes; k++)
+                    s[k] = _mm_aesenc_si128(s[k], _mm_loadu_si128((const __m128i *)(rk7 + k * KEY_SIZE * 8 + r * 16)));
+            for (size_t k = 0; k < lanes; k++)
+                s[k] = _mm_aesenclast_si128(s[k], _mm_loadu_si128((const __m128i *)(rk7 + k * KEY_SIZE * 8 + 7 * 16)));
+
+            // 4-round AES-128 of H xor M_i
+            for (size_t k = 0; k < lanes; k++)
+                s[k] = _mm_xor_si128(_mm_xor_si128(s[k], block), _mm_loadu_si128((const __m128i *)(rk7 + k * KEY_SIZE * 8)));
+            for (int r = 1; r < 4; r++)
+                for (size_t k = 0; k < lanes; k++)
+                    s[k] = _mm_aesenc_si128(s[k], _mm_loadu_si128((const __m128i *)(rk7 + k * KEY_SIZE * 8 + r * 16)));
+            for (size_t k = 0; k < lanes; k++)
+                s[k] = _mm_aesenclast_si128(s[k], _mm_loadu_si128((const __m128i *)(rk7 + k * KEY_SIZE * 8 + 4 * 16)));
+
+            for (size_t k = 0; k < lanes; k++)
             {
-                state[j] ^= i_output[j];
+                uint8_t *state = states + (k0 + k) * BLOCK_SIZE;
+                _mm_storeu_si128((__m128i *)state, _mm_xor_si128(_mm_loadu_si128((const __m128i *)state), s[k]));
             }
         }
     }
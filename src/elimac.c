@@ -2,6 +2,27 @@
 
 int elimac(const uint8_t *key1, const uint8_t *key2, const uint8_t *padded_message, size_t padded_len,
            uint8_t *tag, int t, int precompute, size_t max_blocks, int parallel, int variant, const uint8_t *subkeys, uint8_t *round_keys_7)
+{
+    // Key schedules (basically generates round keys for AES)
+    // The 4-round schedule of K1 is the first 5 round keys of its 7-round schedule
+    INSTRUMENT_TIMESTAMP(key_schedule_start);
+    uint8_t local_round_keys_7[KEY_SIZE * 8], round_keys_10[KEY_SIZE * 11];
+    const uint8_t *rk7 = round_keys_7;
+    if (!rk7)
+    {
+        aes_key_schedule(key1, local_round_keys_7, 7);
+        rk7 = local_round_keys_7;
+    }
+    aes_key_schedule(key2, round_keys_10, 10);
+    INSTRUMENT_ADD(key_schedule, key_schedule_start);
+
+    return elimac_expanded(rk7, rk7, round_keys_10, padded_message, padded_len, tag, t, precompute, max_blocks, parallel, variant, subkeys);
+}
+
+// EliMAC with already expanded round keys
+int elimac_expanded(const uint8_t *round_keys_7, const uint8_t *round_keys_4, const uint8_t *round_keys_10,
+                    const uint8_t *padded_message, size_t padded_len, uint8_t *tag, int t, int precompute,
+                    size_t max_blocks, int parallel, int variant, const uint8_t *subkeys)
 {
     // verify tag length
     if (t > 128 || t < 0)
@@ -18,18 +39,14 @@ int elimac(const uint8_t *key1, const uint8_t *key2, const uint8_t *padded_messa
         return -1;
     }
 
-    // Key schedules (basically generates round keys for AES)
-    uint8_t local_round_keys_7[KEY_SIZE * 8], round_keys_4[KEY_SIZE * 5], round_keys_10[KEY_SIZE * 11];
-    if (!round_keys_7 || round_keys_7 == NULL)
-    {
-        aes_key_schedule(key1, local_round_keys_7, 7);
-    }
-    else
+    // auto mode: take the strategy from the calibrated profile
+    if (precompute == ELIMAC_AUTO || parallel == ELIMAC_AUTO)
     {
-        memcpy(local_round_keys_7, round_keys_7, KEY_SIZE * 8);
+        int auto_precompute = precompute == ELIMAC_AUTO;
+        tuner_select(num_blocks, variant, &precompute, &parallel);
+        if (auto_precompute && precompute && (!subkeys || max_blocks + 1 < num_blocks))
+            precompute = 0;
     }
-    aes_key_schedule(key1, round_keys_4, 4);
-    aes_key_schedule(key2, round_keys_10, 10);
 
     // validate subkeys if precomputation is enabled
     if (precompute && max_blocks > 0 && !subkeys)
@@ -40,11 +57,13 @@ int elimac(const uint8_t *key1, const uint8_t *key2, const uint8_t *padded_messa
 
     // Initialize state
     uint8_t state[BLOCK_SIZE] = {0};
+    INSTRUMENT_CALL();
 
     // process blocks 1 to l-1
-    elihash(state, num_blocks, local_round_keys_7, subkeys, precompute, padded_message, round_keys_4, parallel, variant);
+    elihash(state, num_blocks, round_keys_7, subkeys, precompute, padded_message, round_keys_4, parallel, variant);
 
     // Last block: S = S XOR M_l
+    INSTRUMENT_TIMESTAMP(stage_start);
     if (num_blocks > 0)
     {
         for (int j = 0; j < BLOCK_SIZE; j++)
@@ -52,15 +71,81 @@ int elimac(const uint8_t *key1, const uint8_t *key2, const uint8_t *padded_messa
             state[j] ^= padded_message[(num_blocks - 1) * BLOCK_SIZE + j];
         }
     }
+    INSTRUMENT_LAP(last_block, stage_start);
 
     // Finally: T = E_K2(S)
     // 10-round AES-128
     uint8_t final[BLOCK_SIZE];
     aes_encrypt(state, round_keys_10, final, 10);
+    INSTRUMENT_ADD(final_aes, stage_start);
 
     // copy tag (and truncate if necessary)
     memcpy(tag, final, t / 8);
 
     // free(padded);
     return 0;
+}
+
+// One message, num_keys key pairs (keys1/keys2 hold KEY_SIZE bytes per key).
+// Tag k is written to tags + k * BLOCK_SIZE.
+int elimac_multi(const uint8_t *keys1, const uint8_t *keys2, size_t num_keys, const uint8_t *padded_message, size_t padded_len,
+                 uint8_t *tags, int t, int variant)
+{
+    // verify tag length
+    if (t > 128 || t < 0)
+    {
+        fprintf(stderr, "Tag length must be <= 128 bits\n");
+        return -1;
+    }
+
+    // calculate number of blocks
+    size_t num_blocks = padded_len / BLOCK_SIZE;
+    if (num_blocks > MAX_BLOCKS)
+    {
+        fprintf(stderr, "Message too long\n");
+        return -1;
+    }
+    if (num_keys == 0)
+        return 0;
+
+    // Key schedules for every key, laid out per rounds count so lanes are contiguous
+    uint8_t *round_keys = malloc(num_keys * KEY_SIZE * (8 + 11));
+    uint8_t *states = calloc(num_keys, BLOCK_SIZE);
+    if (!round_keys || !states)
+    {
+        fprintf(stderr, "Memory allocation failed\n");
+        free(round_keys);
+        free(states);
+        return -1;
+    }
+    uint8_t *round_keys_7 = round_keys;
+    uint8_t *round_keys_10 = round_keys_7 + num_keys * KEY_SIZE * 8;
+    aes_key_schedule_batch(keys1, round_keys_7, num_keys, 7);
+    aes_key_schedule_batch(keys2, round_keys_10, num_keys, 10);
+
+    // process blocks 1 to l-1 for all keys at once
+    elihash_multi(states, num_keys, num_blocks, round_keys_7, padded_message, variant);
+
+    for (size_t k = 0; k < num_keys; k++)
+    {
+        uint8_t *state = states + k * BLOCK_SIZE;
+
+        // Last block: S = S XOR M_l
+        if (num_blocks > 0)
+        {
+            for (int j = 0; j < BLOCK_SIZE; j++)
+            {
+                state[j] ^= padded_message[(num_blocks - 1) * BLOCK_SIZE + j];
+            }
+        }
+
+        // Finally: T = E_K2(S)
+        uint8_t final[BLOCK_SIZE];
+        aes_encrypt(state, round_keys_10 + k * KEY_SIZE * 11, final, 10);
+        memcpy(tags + k * BLOCK_SIZE, final, t / 8);
+    }
+
+    free(states);
+    free(round_keys);
+    return 0;
 }
\ No newline at end of file
@@ -5,8 +5,11 @@
 #include <stddef.h>
 #include "utils.h"
 #include "elimac.h"
+#include "instrument.h"
 #include <string.h>
 
+#define MULTI_LANES 8
+
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -17,10 +20,18 @@ void hash_h(uint32_t counter, uint8_t *output,
 void hash_i(const uint8_t *h_output, const uint8_t *message_block, uint8_t *output,
             const uint8_t *round_keys);
 
-void elihash(uint8_t *state, size_t num_blocks, uint8_t *round_keys_7,
-             const uint8_t *subkeys, int precompute, const uint8_t *padded, uint8_t *round_keys_4, int parallel, int variant);
+void elihash(uint8_t *state, size_t num_blocks, const uint8_t *round_keys_7,
+             const uint8_t *subkeys, int precompute, const uint8_t *padded, const uint8_t *round_keys_4, int parallel, int variant);
+
+void elihash_multi(uint8_t *states, size_t num_keys, size_t num_blocks, const uint8_t *round_keys_7,
+                   const uint8_t *padded, int variant);
 
 void precompute_subkeys(uint8_t *subkeys, size_t max_blocks,
                         const uint8_t *round_keys, int variant);
 
+#ifdef ELIMAC_INSTRUMENT
+void elihash_sample(size_t num_blocks, const uint8_t *round_keys_7, const uint8_t *subkeys, int precompute,
+                    const uint8_t *padded, const uint8_t *round_keys_4, int variant, instrument_sample *sample);
+#endif
+
 #endif
\ No newline at end of file
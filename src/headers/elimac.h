@@ -1,5 +1,6 @@
 #include "elihash.h"
 #include "utils.h"
+#include "tuner.h"
 #include <stdint.h>
 #include <stddef.h>
 #include <stdlib.h>
@@ -16,4 +17,11 @@
 int elimac(const uint8_t *key1, const uint8_t *key2, const uint8_t *message, size_t len,
            uint8_t *tag, int t, int precompute, size_t max_blocks, int parallel, int variant, const uint8_t *subkeys, uint8_t *round_keys_7);
 
+int elimac_expanded(const uint8_t *round_keys_7, const uint8_t *round_keys_4, const uint8_t *round_keys_10,
+                    const uint8_t *padded_message, size_t padded_len, uint8_t *tag, int t, int precompute,
+                    size_t max_blocks, int parallel, int variant, const uint8_t *subkeys);
+
+int elimac_multi(const uint8_t *keys1, const uint8_t *keys2, size_t num_keys, const uint8_t *padded_message, size_t padded_len,
+                 uint8_t *tags, int t, int variant);
+
 #endif
\ No newline at end of file
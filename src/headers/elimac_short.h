@@ -0,0 +1,138 @@
+#ifndef ELIMAC_SHORT_H
+#define ELIMAC_SHORT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <immintrin.h>
+#include "elimac.h"
+
+#define SHORT_MAX_LEN 64
+#define SHORT_MAX_BLOCKS (SHORT_MAX_LEN / BLOCK_SIZE + 1)
+
+#define ELIMAC_SHORT_INLINE static inline __attribute__((always_inline))
+
+// Encoded counter built directly in a register (same bytes as encode_counter)
+ELIMAC_SHORT_INLINE __m128i elimac_short_counter(uint32_t counter, int variant)
+{
+    switch (variant)
+    {
+    case 0: // Naive: big-endian counter repeated four times
+        return _mm_set1_epi32((int)__builtin_bswap32(counter));
+    case 3: // little-endian counter in the last 4 bytes
+        return _mm_set_epi32((int)counter, 0, 0, 0);
+    default: // Compact: big-endian counter in the last 4 bytes
+        return _mm_set_epi32((int)__builtin_bswap32(counter), 0, 0, 0);
+    }
+}
+
+// H/I for blocks 1..n with all lanes interleaved; n is a constant at every call site
+ELIMAC_SHORT_INLINE __m128i elimac_short_hash(const __m128i *blocks, int n, const uint8_t *round_keys_7,
+                                              const uint8_t *round_keys_4, const uint8_t *subkeys, int variant)
+{
+    __m128i s[SHORT_MAX_BLOCKS];
+    if (subkeys)
+    {
+        for (int i = 0; i < n; i++)
+            s[i] = _mm_loadu_si128((const __m128i *)(subkeys + i * BLOCK_SIZE));
+    }
+    else
+    {
+        // 7-round AES-128
+        __m128i rk = _mm_loadu_si128((const __m128i *)round_keys_7);
+        for (int i = 0; i < n; i++)
+            s[i] = _mm_xor_si128(elimac_short_counter(i + 1, variant), rk);
+        for (int r = 1; r < 7; r++)
+        {
+            rk = _mm_loadu_si128((const __m128i *)(round_keys_7 + r * 16));
+            for (int i = 0; i < n; i++)
+                s[i] = _mm_aesenc_si128(s[i], rk);
+        }
+        rk = _mm_loadu_si128((const __m128i *)(round_keys_7 + 7 * 16));
+        for (int i = 0; i < n; i++)
+            s[i] = _mm_aesenclast_si128(s[i], rk);
+    }
+
+    // 4-round AES-128
+    __m128i rk = _mm_loadu_si128((const __m128i *)round_keys_4);
+    for (int i = 0; i < n; i++)
+        s[i] = _mm_xor_si128(_mm_xor_si128(s[i], blocks[i]), rk);
+    for (int r = 1; r < 4; r++)
+    {
+        rk = _mm_loadu_si128((const __m128i *)(round_keys_4 + r * 16));
+        for (int i = 0; i < n; i++)
+            s[i] = _mm_aesenc_si128(s[i], rk);
+    }
+    rk = _mm_loadu_si128((const __m128i *)(round_keys_4 + 4 * 16));
+    __m128i state = _mm_setzero_si128();
+    for (int i = 0; i < n; i++)
+        state = _mm_xor_si128(state, _mm_aesenclast_si128(s[i], rk));
+    return state;
+}
+
+// EliMAC for messages of at most SHORT_MAX_LEN bytes (unpadded) with pre-expanded
+// keys. subkeys may hold the precomputed H values for counters 1..4, or be NULL.
+ELIMAC_SHORT_INLINE int elimac_short(const uint8_t *round_keys_7, const uint8_t *round_keys_4, const uint8_t *round_keys_10,
+                                     const uint8_t *subkeys, const uint8_t *message, size_t len, uint8_t *tag, int t, int variant)
+{
+    if (len > SHORT_MAX_LEN || t > 128 || t < 0 || variant < 0 || variant > 3)
+        return -1;
+
+    // Pad on the stack: full blocks are loaded as is, the last one gets 10* padding
+    size_t full = len / BLOCK_SIZE;
+    size_t remainder = len - full * BLOCK_SIZE;
+    uint8_t last[BLOCK_SIZE] = {0};
+    memcpy(last, message + full * BLOCK_SIZE, remainder);
+    last[remainder] = 0x80;
+
+    __m128i blocks[SHORT_MAX_BLOCKS];
+    for (size_t i = 0; i < full; i++)
+        blocks[i] = _mm_loadu_si128((const __m128i *)(message + i * BLOCK_SIZE));
+    blocks[full] = _mm_loadu_si128((const __m128i *)last);
+
+    // process blocks 1 to l-1, one fixed unrolled body per block count
+    __m128i state;
+    switch (full)
+    {
+    case 0:
+        state = _mm_setzero_si128();
+        break;
+    case 1:
+        state = elimac_short_hash(blocks, 1, round_keys_7, round_keys_4, subkeys, variant);
+        break;
+    case 2:
+        state = elimac_short_hash(blocks, 2, round_keys_7, round_keys_4, subkeys, variant);
+        break;
+    case 3:
+        state = elimac_short_hash(blocks, 3, round_keys_7, round_keys_4, subkeys, variant);
+        break;
+    default:
+        state = elimac_short_hash(blocks, 4, round_keys_7, round_keys_4, subkeys, variant);
+        break;
+    }
+
+    // Last block: S = S XOR M_l
+    state = _mm_xor_si128(state, blocks[full]);
+
+    // Finally: T = E_K2(S)
+    // 10-round AES-128
+    state = _mm_xor_si128(state, _mm_loadu_si128((const __m128i *)round_keys_10));
+    for (int r = 1; r < 10; r++)
+        state = _mm_aesenc_si128(state, _mm_loadu_si128((const __m128i *)(round_keys_10 + r * 16)));
+    state = _mm_aesenclast_si128(state, _mm_loadu_si128((const __m128i *)(round_keys_10 + 10 * 16)));
+
+    // copy tag (and truncate if necessary)
+    if (t == 128)
+    {
+        _mm_storeu_si128((__m128i *)tag, state);
+    }
+    else
+    {
+        uint8_t final[BLOCK_SIZE];
+        _mm_storeu_si128((__m128i *)final, state);
+        memcpy(tag, final, t / 8);
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+#include <stdint.h>
+#include <x86intrin.h>
+
+#define INSTRUMENT_MAX_THREADS 256
+// blocks run through each of the H-only and I-only sample passes
+#define INSTRUMENT_SAMPLE_BLOCKS 4096
+
+// Per-stage cycle totals since the last instrument_reset(). All stages are wall
+// time of the calling thread. hash_loop is the whole elihash block loop; hash_h and
+// hash_i are only filled in by instrument_split(). thread_work is per-thread busy
+// time in the parallel elihash and only feeds the imbalance. Only meaningful when one thread at a
+// time calls elimac() (as in the test suite).
+typedef struct
+{
+    uint64_t key_schedule;
+    uint64_t hash_loop;
+    uint64_t hash_h;
+    uint64_t hash_i;
+    uint64_t last_block;
+    uint64_t final_aes;
+    uint64_t calls;
+    uint64_t thread_work[INSTRUMENT_MAX_THREADS];
+    int threads;
+    uint64_t timestamp_overhead;
+} instrument_stats;
+
+// Cycles of an H-only and an I-only pass over the same blocks (see elihash_sample)
+typedef struct
+{
+    uint64_t h;
+    uint64_t i;
+} instrument_sample;
+
+extern instrument_stats elimac_stats;
+
+void instrument_reset(void);
+void instrument_split(const instrument_sample *sample);
+void instrument_thread_work(int thread, int threads, uint64_t cycles);
+double instrument_imbalance(void);
+
+static inline uint64_t instrument_now(void)
+{
+    _mm_lfence();
+    uint64_t t = __rdtsc();
+    _mm_lfence();
+    return t;
+}
+
+// Cycles since start, less the cost of taking the timestamps
+static inline uint64_t instrument_elapsed(uint64_t start)
+{
+    uint64_t cycles = instrument_now() - start;
+    return cycles > elimac_stats.timestamp_overhead ? cycles - elimac_stats.timestamp_overhead : 0;
+}
+
+// Charge field up to now and move the mark there, so adjacent stages share a timestamp
+static inline void instrument_lap(uint64_t *field, uint64_t *mark)
+{
+    uint64_t now = instrument_now();
+    uint64_t cycles = now - *mark;
+    *field += cycles > elimac_stats.timestamp_overhead ? cycles - elimac_stats.timestamp_overhead : 0;
+    *mark = now;
+}
+
+// Build with -DELIMAC_INSTRUMENT (make INSTRUMENT=1); otherwise every hook is empty
+#ifdef ELIMAC_INSTRUMENT
+#define INSTRUMENT_TIMESTAMP(name) uint64_t name = instrument_now()
+#define INSTRUMENT_ELAPSED(name, start) uint64_t name = instrument_elapsed(start)
+#define INSTRUMENT_ADD(field, start) (elimac_stats.field += instrument_elapsed(start))
+#define INSTRUMENT_LAP(field, mark) instrument_lap(&elimac_stats.field, &(mark))
+#define INSTRUMENT_THREAD_WORK(thread, threads, cycles) instrument_thread_work((thread), (threads), (cycles))
+#define INSTRUMENT_CALL() (elimac_stats.calls++)
+#else
+#define INSTRUMENT_TIMESTAMP(name)
+#define INSTRUMENT_ELAPSED(name, start)
+#define INSTRUMENT_ADD(field, start)
+#define INSTRUMENT_LAP(field, mark)
+#define INSTRUMENT_THREAD_WORK(thread, threads, cycles)
+#define INSTRUMENT_CALL()
+#endif
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef KEYSET_H
+#define KEYSET_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "elimac.h"
+
+// One generation of expanded key material
+typedef struct
+{
+    uint8_t key1[KEY_SIZE];
+    uint8_t key2[KEY_SIZE];
+    uint8_t round_keys_7[KEY_SIZE * 8];
+    uint8_t round_keys_10[KEY_SIZE * 11];
+    uint8_t *subkeys;
+} keyset_tables;
+
+// Double-buffered key set: MACs read the current tables without locks while the
+// next generation is built in the background, then published with an epoch flip.
+// keyset_mac may run on any thread; rotate/wait/destroy belong to one control thread.
+typedef struct
+{
+    _Atomic(keyset_tables *) current;
+    atomic_uint epoch;
+    atomic_uint readers[2];
+    atomic_int rotating;
+    keyset_tables *pending;
+    pthread_t builder;
+    int has_builder;
+    size_t max_blocks;
+    int variant;
+} keyset;
+
+int keyset_init(keyset *ks, const uint8_t *key1, const uint8_t *key2, size_t max_blocks, int variant);
+int keyset_rotate(keyset *ks, const uint8_t *key1, const uint8_t *key2);
+int keyset_wait(keyset *ks);
+int keyset_mac(keyset *ks, const uint8_t *padded_message, size_t padded_len, uint8_t *tag, int t, int parallel);
+void keyset_destroy(keyset *ks);
+
+#endif
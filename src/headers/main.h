@@ -1,5 +1,7 @@
 #include "elimac.h"
 #include "utils.h"
+#include "elimac_short.h"
+#include "keyset.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -12,19 +14,37 @@
 #define DEFAULT_OUTPUT_FORMAT "csv"
 #define SEED 42
 #define DEFAULT_MESSAGE "Hello, EliMAC!"
+#define DEFAULT_MULTI_KEYS 16
+#define MAX_MULTI_KEYS 1024
+#define ROTATION_MACS 200000
+#define ROTATION_INTERVAL 20000
+#define ROTATION_TABLE_BLOCKS 65536
+#define ROTATION_MESSAGE_LENGTH 1024
+#define ROTATION_WARMUP 1000
 
 #ifndef MAIN_H
 #define MAIN_H
 
 double test_elimac(FILE *output_file, const char *output_format, const uint8_t *key1,
                    const uint8_t *key2, const uint8_t *message, size_t message_length,
-                   int tag_bits, int parallel, int precompute, size_t max_blocks, uint8_t *tag, int verbose, int variant);
+                   int tag_bits, int parallel, int precompute, size_t max_blocks, uint8_t *tag, int verbose, int variant,
+                   const char *kernel);
+
+double test_elimac_short(FILE *output_file, const char *output_format, const uint8_t *key1,
+                         const uint8_t *key2, const uint8_t *message, size_t message_length,
+                         int tag_bits, uint8_t *tag, int variant);
 
 void run_test_suite(FILE *fp, const char *output_format, int encoding);
 
 void run_single_message(FILE *fp, const char *output_format, const char *message,
                         int random_keys, int precompute, int tag_bits, int parallel, int encoding);
 
+void run_multi_key_benchmark(FILE *fp, const char *output_format, int num_keys, int encoding);
+
+void run_rotation_benchmark(FILE *fp, const char *output_format, int encoding);
+
+void run_key_agile_benchmark(FILE *fp, const char *output_format, int encoding);
+
 int main(int argc, char *argv[]);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,30 @@
+#ifndef TUNER_H
+#define TUNER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define ELIMAC_AUTO -1
+#define TUNER_PROFILE_PATH "out/elimac_profile.csv"
+#define TUNER_MAX_ENTRIES 64
+#define TUNER_NUM_VARIANTS 4
+#define TUNER_BYTES_PER_RUN (1 << 24)
+#define TUNER_MIN_ITERATIONS 16
+#define TUNER_MAX_ITERATIONS 20000
+#define TUNER_DEFAULT_PARALLEL_BLOCKS 1024
+
+typedef struct
+{
+    int variant;
+    size_t blocks;
+    int precompute;
+    int parallel;
+    double cycles_per_byte;
+} tuner_entry;
+
+int tuner_calibrate(const char *path, FILE *log);
+int tuner_load(const char *path);
+void tuner_select(size_t num_blocks, int variant, int *precompute, int *parallel);
+
+#endif
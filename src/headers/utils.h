@@ -9,7 +9,11 @@
 #include <stdlib.h>
 #include <string.h>
 
+#define KEY_BATCH_LANES 8
+
 int aes_key_schedule(const uint8_t *key, uint8_t *round_keys, int rounds);
+int aes_key_schedule_table(const uint8_t *key, uint8_t *round_keys, int rounds);
+int aes_key_schedule_batch(const uint8_t *keys, uint8_t *round_keys, size_t num_keys, int rounds);
 void aes_encrypt(const uint8_t *input, const uint8_t *round_keys, uint8_t *output, int rounds);
 int encode_counter(uint32_t counter, uint8_t *output, int variant);
 int pad_message(const uint8_t *message, size_t len, uint8_t **padded, size_t *padded_len);
@@ -0,0 +1,57 @@
+#include "headers/instrument.h"
+#include <string.h>
+
+instrument_stats elimac_stats;
+
+void instrument_reset(void)
+{
+    memset(&elimac_stats, 0, sizeof(elimac_stats));
+
+    // cheapest back-to-back timestamp pair, subtracted from every stage
+    uint64_t overhead = UINT64_MAX;
+    for (int i = 0; i < 1000; i++)
+    {
+        uint64_t start = instrument_now();
+        uint64_t cycles = instrument_now() - start;
+        if (cycles < overhead)
+            overhead = cycles;
+    }
+    elimac_stats.timestamp_overhead = overhead;
+}
+
+// Estimate hash_h and hash_i by splitting the measured block loop time in the
+// sampled H:I ratio; neither is timed on its own inside the loop
+void instrument_split(const instrument_sample *sample)
+{
+    uint64_t sampled = sample->h + sample->i;
+    elimac_stats.hash_h = 0;
+    elimac_stats.hash_i = 0;
+    if (sampled == 0)
+        return;
+    elimac_stats.hash_h = (uint64_t)((double)elimac_stats.hash_loop * sample->h / sampled);
+    elimac_stats.hash_i = elimac_stats.hash_loop - elimac_stats.hash_h;
+}
+
+void instrument_thread_work(int thread, int threads, uint64_t cycles)
+{
+    if (thread < 0 || thread >= INSTRUMENT_MAX_THREADS)
+        return;
+    if (threads > elimac_stats.threads)
+        elimac_stats.threads = threads > INSTRUMENT_MAX_THREADS ? INSTRUMENT_MAX_THREADS : threads;
+    elimac_stats.thread_work[thread] += cycles;
+}
+
+// Busiest thread's block-loop time over the mean (1.0 = perfectly balanced)
+double instrument_imbalance(void)
+{
+    uint64_t max = 0, total = 0;
+    for (int i = 0; i < elimac_stats.threads; i++)
+    {
+        total += elimac_stats.thread_work[i];
+        if (elimac_stats.thread_work[i] > max)
+            max = elimac_stats.thread_work[i];
+    }
+    if (total == 0)
+        return 0.0;
+    return (double)max * elimac_stats.threads / total;
+}
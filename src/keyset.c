@@ -0,0 +1,163 @@
+#include "headers/keyset.h"
+#include "headers/elihash.h"
+#include "headers/utils.h"
+#include <sched.h>
+
+static keyset_tables *keyset_build(const uint8_t *key1, const uint8_t *key2, size_t max_blocks, int variant)
+{
+    keyset_tables *tables = malloc(sizeof(keyset_tables));
+    if (!tables)
+    {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    memcpy(tables->key1, key1, KEY_SIZE);
+    memcpy(tables->key2, key2, KEY_SIZE);
+    tables->subkeys = NULL;
+    if (aes_key_schedule(key1, tables->round_keys_7, 7) < 0 || aes_key_schedule(key2, tables->round_keys_10, 10) < 0)
+    {
+        free(tables);
+        return NULL;
+    }
+    if (max_blocks > 0)
+    {
+        tables->subkeys = malloc(max_blocks * BLOCK_SIZE);
+        if (!tables->subkeys)
+        {
+            fprintf(stderr, "Memory allocation failed\n");
+            free(tables);
+            return NULL;
+        }
+        precompute_subkeys(tables->subkeys, max_blocks, tables->round_keys_7, variant);
+    }
+    return tables;
+}
+
+static void keyset_free_tables(keyset_tables *tables)
+{
+    if (!tables)
+        return;
+    free(tables->subkeys);
+    free(tables);
+}
+
+// Background builder: expand the pending keys, publish them and retire the old
+// tables once every MAC that may still see them has finished
+static void *keyset_builder(void *arg)
+{
+    keyset *ks = arg;
+    keyset_tables *next = keyset_build(ks->pending->key1, ks->pending->key2, ks->max_blocks, ks->variant);
+    free(ks->pending);
+    ks->pending = NULL;
+    if (next)
+    {
+        keyset_tables *old = atomic_exchange(&ks->current, next);
+        unsigned int epoch = atomic_fetch_add(&ks->epoch, 1);
+        while (atomic_load(&ks->readers[epoch & 1]) != 0)
+            sched_yield();
+        keyset_free_tables(old);
+    }
+    atomic_store(&ks->rotating, 0);
+    return next;
+}
+
+int keyset_init(keyset *ks, const uint8_t *key1, const uint8_t *key2, size_t max_blocks, int variant)
+{
+    if (!ks || !key1 || !key2)
+    {
+        fprintf(stderr, "Null pointer in keyset_init\n");
+        return -1;
+    }
+    ks->max_blocks = max_blocks;
+    ks->variant = variant;
+    ks->pending = NULL;
+    ks->has_builder = 0;
+    atomic_init(&ks->epoch, 0);
+    atomic_init(&ks->readers[0], 0);
+    atomic_init(&ks->readers[1], 0);
+    atomic_init(&ks->rotating, 0);
+    keyset_tables *tables = keyset_build(key1, key2, max_blocks, variant);
+    if (!tables)
+        return -1;
+    atomic_init(&ks->current, tables);
+    return 0;
+}
+
+// Start building the tables for a new key pair; returns without waiting
+int keyset_rotate(keyset *ks, const uint8_t *key1, const uint8_t *key2)
+{
+    int expected = 0;
+    if (!atomic_compare_exchange_strong(&ks->rotating, &expected, 1))
+    {
+        fprintf(stderr, "Key rotation already in progress\n");
+        return -1;
+    }
+    keyset_wait(ks);
+
+    ks->pending = malloc(sizeof(keyset_tables));
+    if (!ks->pending)
+    {
+        fprintf(stderr, "Memory allocation failed\n");
+        atomic_store(&ks->rotating, 0);
+        return -1;
+    }
+    memcpy(ks->pending->key1, key1, KEY_SIZE);
+    memcpy(ks->pending->key2, key2, KEY_SIZE);
+    if (pthread_create(&ks->builder, NULL, keyset_builder, ks) != 0)
+    {
+        fprintf(stderr, "Failed to start key rotation\n");
+        free(ks->pending);
+        ks->pending = NULL;
+        atomic_store(&ks->rotating, 0);
+        return -1;
+    }
+    ks->has_builder = 1;
+    return 0;
+}
+
+// Join the last background builder (if any); 0 if its tables were published
+int keyset_wait(keyset *ks)
+{
+    int ret = 0;
+    if (ks->has_builder)
+    {
+        void *result;
+        pthread_join(ks->builder, &result);
+        ks->has_builder = 0;
+        ret = result ? 0 : -1;
+    }
+    return ret;
+}
+
+int keyset_mac(keyset *ks, const uint8_t *padded_message, size_t padded_len, uint8_t *tag, int t, int parallel)
+{
+    // Enter the read side: count this MAC against the current epoch, retrying
+    // if a flip happened in between so the builder is sure to wait for us
+    unsigned int epoch;
+    for (;;)
+    {
+        epoch = atomic_load(&ks->epoch);
+        atomic_fetch_add(&ks->readers[epoch & 1], 1);
+        if (atomic_load(&ks->epoch) == epoch)
+            break;
+        atomic_fetch_sub(&ks->readers[epoch & 1], 1);
+    }
+    keyset_tables *tables = atomic_load(&ks->current);
+
+    size_t num_blocks = padded_len / BLOCK_SIZE;
+    int precompute = tables->subkeys && num_blocks <= ks->max_blocks + 1;
+    // the 4-round schedule of K1 is a prefix of its 7-round schedule
+    int ret = elimac_expanded(tables->round_keys_7, tables->round_keys_7, tables->round_keys_10, padded_message, padded_len,
+                              tag, t, precompute, precompute ? ks->max_blocks : 0, parallel, ks->variant,
+                              precompute ? tables->subkeys : NULL);
+
+    atomic_fetch_sub(&ks->readers[epoch & 1], 1);
+    return ret;
+}
+
+void keyset_destroy(keyset *ks)
+{
+    keyset_wait(ks);
+    keyset_free_tables(atomic_load(&ks->current));
+    atomic_store(&ks->current, NULL);
+}
@@ -1,7 +1,7 @@
 #include "headers/main.h"
 
 double test_elimac(FILE *output_file, const char *output_format, const uint8_t *key1, const uint8_t *key2, const uint8_t *message, size_t len,
-                   int tag_bits, int parallel, int precompute, size_t max_blocks, uint8_t *tag, int verbose, int variant)
+                   int tag_bits, int parallel, int precompute, size_t max_blocks, uint8_t *tag, int verbose, int variant, const char *kernel)
 {
     int ret;
     double result = 0.0;
@@ -15,6 +15,15 @@ double test_elimac(FILE *output_file, const char *output_format, const uint8_t *
         return -1.0;
     }
 
+    // auto mode: resolve the strategy once for this length so the row records what ran
+    if (precompute == ELIMAC_AUTO || parallel == ELIMAC_AUTO)
+    {
+        int auto_precompute = precompute == ELIMAC_AUTO;
+        tuner_select(padded_len / BLOCK_SIZE, variant, &precompute, &parallel);
+        if (auto_precompute && precompute && max_blocks == 0)
+            precompute = 0;
+    }
+
     // Precompute subkeys and round_keys_7 outside timing loop
     uint8_t *subkeys = NULL;
     uint8_t round_keys_7[KEY_SIZE * 8] = {0};
@@ -48,6 +57,9 @@ double test_elimac(FILE *output_file, const char *output_format, const uint8_t *
     }
 
     // Timing with rdtsc
+#ifdef ELIMAC_INSTRUMENT
+    instrument_reset();
+#endif
     uint64_t start, end, total_cycles = 0;
     for (int i = 0; i < ITERATIONS; i++)
     {
@@ -67,6 +79,13 @@ double test_elimac(FILE *output_file, const char *output_format, const uint8_t *
         total_cycles += (end - start);
     }
 
+#ifdef ELIMAC_INSTRUMENT
+    // split the measured loop time between H and I with one sample pass, untimed
+    instrument_sample sample;
+    elihash_sample(padded_len / BLOCK_SIZE, round_keys_7, subkeys, precompute && subkeys, padded, round_keys_7, variant, &sample);
+    instrument_split(&sample);
+#endif
+
     double cycles_per_byte = (double)total_cycles / (ITERATIONS * len);
     double time_us = cycles_per_byte * len / (CPU_FREQ * 1e3); // Convert to µs
 
@@ -74,7 +93,15 @@ double test_elimac(FILE *output_file, const char *output_format, const uint8_t *
     {
         fprintf(output_file, "%zu;%d;%d;%d;%d;%d;0;", len, tag_bits, precompute, parallel, verbose, variant);
         print_tag(output_file, tag, tag_bits, 0);
-        fprintf(output_file, ";%.2f;%.2f\n", time_us, cycles_per_byte);
+        fprintf(output_file, ";%.2f;%.2f;%s", time_us, cycles_per_byte, kernel);
+#ifdef ELIMAC_INSTRUMENT
+        // average cycles per call for each stage
+        double calls = elimac_stats.calls ? (double)elimac_stats.calls : 1.0;
+        fprintf(output_file, ";%.2f;%.2f;%.2f;%.2f;%.2f;%d;%.2f",
+                elimac_stats.key_schedule / calls, elimac_stats.hash_h / calls, elimac_stats.hash_i / calls,
+                elimac_stats.last_block / calls, elimac_stats.final_aes / calls, elimac_stats.threads, instrument_imbalance());
+#endif
+        fprintf(output_file, "\n");
         result = cycles_per_byte;
     }
     else
@@ -94,6 +121,63 @@ double test_elimac(FILE *output_file, const char *output_format, const uint8_t *
     return result;
 }
 
+double test_elimac_short(FILE *output_file, const char *output_format, const uint8_t *key1, const uint8_t *key2, const uint8_t *message, size_t len,
+                         int tag_bits, uint8_t *tag, int variant)
+{
+    double result = 0.0;
+
+    // Keys are expanded once, outside timing loop
+    uint8_t round_keys_7[KEY_SIZE * 8], round_keys_4[KEY_SIZE * 5], round_keys_10[KEY_SIZE * 11];
+    if (aes_key_schedule(key1, round_keys_7, 7) < 0 || aes_key_schedule(key1, round_keys_4, 4) < 0 ||
+        aes_key_schedule(key2, round_keys_10, 10) < 0)
+    {
+        fprintf(stderr, "AES key schedule failed\n");
+        return -1.0;
+    }
+
+    // Warm-up run
+    if (elimac_short(round_keys_7, round_keys_4, round_keys_10, NULL, message, len, tag, tag_bits, variant) != 0)
+    {
+        fprintf(stderr, "EliMAC short path warm-up failed\n");
+        return -1.0;
+    }
+
+    // Timing with rdtsc
+    uint64_t start, end, total_cycles = 0;
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        _mm_lfence();
+        start = __rdtsc();
+        elimac_short(round_keys_7, round_keys_4, round_keys_10, NULL, message, len, tag, tag_bits, variant);
+        _mm_lfence();
+        end = __rdtsc();
+        total_cycles += (end - start);
+    }
+
+    double cycles_per_byte = (double)total_cycles / (ITERATIONS * len);
+    double time_us = cycles_per_byte * len / (CPU_FREQ * 1e3); // Convert to µs
+
+    if (strcmp(output_format, "csv") == 0)
+    {
+        fprintf(output_file, "%zu;%d;0;0;0;%d;0;", len, tag_bits, variant);
+        print_tag(output_file, tag, tag_bits, 0);
+        fprintf(output_file, ";%.2f;%.2f;short", time_us, cycles_per_byte);
+#ifdef ELIMAC_INSTRUMENT
+        fprintf(output_file, ";;;;;;;");
+#endif
+        fprintf(output_file, "\n");
+        result = cycles_per_byte;
+    }
+    else
+    {
+        fprintf(output_file, "Tag: ");
+        print_tag(output_file, tag, tag_bits, 0);
+        fprintf(output_file, "\n");
+        result = time_us;
+    }
+    return result;
+}
+
 void run_test_suite(FILE *output_file, const char *output_format, int encoding)
 {
     srand(SEED);
@@ -138,7 +222,7 @@ void run_test_suite(FILE *output_file, const char *output_format, int encoding)
 
                     if (strcmp(output_format, "txt") == 0)
                         fprintf(output_file, "\nFixed keys, no precomputation, %d-bit tag:\n", tag_len);
-                    double time_no_precomp = test_elimac(output_file, output_format, fixed_key1, fixed_key2, message, len, tag_len, parallel, 0, 0, tag, 0, enc);
+                    double time_no_precomp = test_elimac(output_file, output_format, fixed_key1, fixed_key2, message, len, tag_len, parallel, 0, 0, tag, 0, enc, "general");
                     if (time_no_precomp < 0)
                     {
                         free(message);
@@ -149,7 +233,7 @@ void run_test_suite(FILE *output_file, const char *output_format, int encoding)
 
                     if (strcmp(output_format, "txt") == 0)
                         fprintf(output_file, "\nFixed keys, precomputation (%u blocks), %d-bit tag:\n", max_blocks, tag_len);
-                    double time_precomp = test_elimac(output_file, output_format, fixed_key1, fixed_key2, message, len, tag_len, parallel, 1, max_blocks, tag, 0, enc);
+                    double time_precomp = test_elimac(output_file, output_format, fixed_key1, fixed_key2, message, len, tag_len, parallel, 1, max_blocks, tag, 0, enc, "general");
                     if (time_precomp < 0)
                     {
                         free(message);
@@ -167,7 +251,7 @@ void run_test_suite(FILE *output_file, const char *output_format, int encoding)
 
                     if (strcmp(output_format, "txt") == 0)
                         fprintf(output_file, "\nRandom keys, no precomputation, %d-bit tag:\n", tag_len);
-                    time_no_precomp = test_elimac(output_file, output_format, random_key1, random_key2, message, len, tag_len, parallel, 0, 0, tag, 0, enc);
+                    time_no_precomp = test_elimac(output_file, output_format, random_key1, random_key2, message, len, tag_len, parallel, 0, 0, tag, 0, enc, "general");
                     if (time_no_precomp < 0)
                     {
                         free(message);
@@ -178,7 +262,7 @@ void run_test_suite(FILE *output_file, const char *output_format, int encoding)
 
                     if (strcmp(output_format, "txt") == 0)
                         fprintf(output_file, "\nRandom keys, precomputation (%u blocks), %d-bit tag:\n", max_blocks, tag_len);
-                    time_precomp = test_elimac(output_file, output_format, random_key1, random_key2, message, len, tag_len, parallel, 1, max_blocks, tag, 0, enc);
+                    time_precomp = test_elimac(output_file, output_format, random_key1, random_key2, message, len, tag_len, parallel, 1, max_blocks, tag, 0, enc, "general");
                     if (time_precomp < 0)
                     {
                         free(message);
@@ -194,6 +278,38 @@ void run_test_suite(FILE *output_file, const char *output_format, int encoding)
             }
         }
     }
+
+    // Short-message fast path next to the general path
+    uint32_t short_lengths[] = {1, 8, 15, 16, 31, 32, 48, 63, 64};
+    int num_short_lengths = 9;
+    uint8_t short_message[SHORT_MAX_LEN];
+    uint8_t short_tag[BLOCK_SIZE];
+    generate_random_message(short_message, SHORT_MAX_LEN);
+
+    for (int enc = start_encoding; enc < end_encoding; enc++)
+    {
+        for (int l = 0; l < num_short_lengths; l++)
+        {
+            uint32_t len = short_lengths[l];
+
+            if (strcmp(output_format, "txt") == 0)
+                fprintf(output_file, "\nShort message: %u bytes, Encoding: %d\nGeneral path: ", len, enc);
+            double time_general = test_elimac(output_file, output_format, fixed_key1, fixed_key2, short_message, len, 128, 0, 0, 0, tag, 0, enc, "general-short");
+            if (time_general < 0)
+                return;
+
+            if (strcmp(output_format, "txt") == 0)
+                fprintf(output_file, "Short path: ");
+            double time_short = test_elimac_short(output_file, output_format, fixed_key1, fixed_key2, short_message, len, 128, short_tag, enc);
+            if (time_short < 0)
+                return;
+
+            if (memcmp(tag, short_tag, BLOCK_SIZE) != 0)
+                fprintf(stderr, "Short path tag differs from general path (length %u, encoding %d)\n", len, enc);
+            if (strcmp(output_format, "txt") == 0)
+                fprintf(output_file, "Speedup: %.2fx\n", time_general / time_short);
+        }
+    }
 }
 
 void run_single_message(FILE *output_file, const char *output_format, const char *message, int random_keys, int precompute, int tag_bits, int parallel, int encoding)
@@ -226,10 +342,11 @@ void run_single_message(FILE *output_file, const char *output_format, const char
             fprintf(output_file, "\nRunning EliMAC on message: \"%s\" (%u bytes, %u blocks), Encoding: %s\n",
                     message, len, max_blocks, enc ? "Compact" : "Naive");
             fprintf(output_file, "Random keys: %s, Precomputation: %s, Tag size: %d bits, Parallel: %s\n",
-                    random_keys ? "Yes" : "No", precompute ? "Yes" : "No", tag_bits, parallel ? "Yes" : "No");
+                    random_keys ? "Yes" : "No", precompute == ELIMAC_AUTO ? "Auto" : (precompute ? "Yes" : "No"), tag_bits,
+                    parallel == ELIMAC_AUTO ? "Auto" : (parallel ? "Yes" : "No"));
             printf("Tag: ");
         }
-        double result = test_elimac(output_file, output_format, key1, key2, (uint8_t *)message, len, tag_bits, parallel, precompute, max_blocks, tag, 1, enc);
+        double result = test_elimac(output_file, output_format, key1, key2, (uint8_t *)message, len, tag_bits, parallel, precompute, max_blocks, tag, 1, enc, "general");
         if (result < 0)
         {
             fprintf(stderr, "EliMAC failed for single message\n");
@@ -243,6 +360,381 @@ void run_single_message(FILE *output_file, const char *output_format, const char
     }
 }
 
+void run_multi_key_benchmark(FILE *output_file, const char *output_format, int num_keys, int encoding)
+{
+    srand(SEED);
+    uint32_t lengths[] = {16, 128, 1024, 10000, 100000};
+    int num_lengths = 5;
+    int tag_bits = 128;
+
+    uint8_t *keys1 = malloc((size_t)num_keys * KEY_SIZE);
+    uint8_t *keys2 = malloc((size_t)num_keys * KEY_SIZE);
+    uint8_t *tags_separate = malloc((size_t)num_keys * BLOCK_SIZE);
+    uint8_t *tags_batch = malloc((size_t)num_keys * BLOCK_SIZE);
+    if (!keys1 || !keys2 || !tags_separate || !tags_batch)
+    {
+        fprintf(stderr, "Memory allocation failed for keys\n");
+        free(keys1);
+        free(keys2);
+        free(tags_separate);
+        free(tags_batch);
+        return;
+    }
+    generate_random_message(keys1, (size_t)num_keys * KEY_SIZE);
+    generate_random_message(keys2, (size_t)num_keys * KEY_SIZE);
+
+    int start_encoding = (encoding == 4) ? 0 : encoding;
+    int end_encoding = (encoding == 4) ? 4 : encoding + 1;
+
+    for (int enc = start_encoding; enc < end_encoding; enc++)
+    {
+        for (int l = 0; l < num_lengths; l++)
+        {
+            uint32_t len = lengths[l];
+            uint8_t *message = malloc(len);
+            if (!message)
+            {
+                fprintf(stderr, "Memory allocation failed for message\n");
+                break;
+            }
+            generate_random_message(message, len);
+
+            uint8_t *padded;
+            size_t padded_len;
+            if (pad_message(message, len, &padded, &padded_len) < 0)
+            {
+                fprintf(stderr, "Message padding failed\n");
+                free(message);
+                break;
+            }
+
+            // Warm-up runs
+            for (int k = 0; k < num_keys; k++)
+            {
+                elimac(keys1 + k * KEY_SIZE, keys2 + k * KEY_SIZE, padded, padded_len, tags_separate + k * BLOCK_SIZE,
+                       tag_bits, 0, 0, 0, enc, NULL, NULL);
+            }
+            elimac_multi(keys1, keys2, num_keys, padded, padded_len, tags_batch, tag_bits, enc);
+
+            // K separate elimac() calls
+            uint64_t start, end, separate_cycles = 0, batch_cycles = 0;
+            for (int i = 0; i < ITERATIONS; i++)
+            {
+                _mm_lfence();
+                start = __rdtsc();
+                for (int k = 0; k < num_keys; k++)
+                {
+                    elimac(keys1 + k * KEY_SIZE, keys2 + k * KEY_SIZE, padded, padded_len, tags_separate + k * BLOCK_SIZE,
+                           tag_bits, 0, 0, 0, enc, NULL, NULL);
+                }
+                _mm_lfence();
+                end = __rdtsc();
+                separate_cycles += (end - start);
+            }
+
+            // One elimac_multi() call
+            for (int i = 0; i < ITERATIONS; i++)
+            {
+                _mm_lfence();
+                start = __rdtsc();
+                elimac_multi(keys1, keys2, num_keys, padded, padded_len, tags_batch, tag_bits, enc);
+                _mm_lfence();
+                end = __rdtsc();
+                batch_cycles += (end - start);
+            }
+
+            int match = memcmp(tags_separate, tags_batch, (size_t)num_keys * BLOCK_SIZE) == 0;
+            if (!match)
+                fprintf(stderr, "Multi-key tags differ from separate calls (length %u, encoding %d)\n", len, enc);
+
+            double bytes = (double)ITERATIONS * num_keys * len;
+            double separate_cpb = separate_cycles / bytes;
+            double batch_cpb = batch_cycles / bytes;
+
+            if (strcmp(output_format, "csv") == 0)
+            {
+                fprintf(output_file, "%u;%d;%d;%d;%.2f;%.2f;%.2f;%d\n", len, num_keys, tag_bits, enc,
+                        separate_cpb, batch_cpb, separate_cpb / batch_cpb, match);
+            }
+            else
+            {
+                fprintf(output_file, "Length: %u bytes, Keys: %d, Encoding: %d\n", len, num_keys, enc);
+                fprintf(output_file, "Separate: %.2f cycles/byte, Batch: %.2f cycles/byte, Speedup: %.2fx%s\n",
+                        separate_cpb, batch_cpb, separate_cpb / batch_cpb, match ? "" : " (TAG MISMATCH)");
+            }
+
+            free(padded);
+            free(message);
+        }
+    }
+
+    free(keys1);
+    free(keys2);
+    free(tags_separate);
+    free(tags_batch);
+}
+
+static int compare_cycles(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+void run_rotation_benchmark(FILE *output_file, const char *output_format, int encoding)
+{
+    srand(SEED);
+    const char *modes[] = {"none", "blocking", "background"};
+    int num_modes = 3;
+    int variant = (encoding == 4) ? 1 : encoding;
+    uint32_t len = ROTATION_MESSAGE_LENGTH;
+
+    uint8_t key1[KEY_SIZE], key2[KEY_SIZE], tag[BLOCK_SIZE];
+    uint8_t message[ROTATION_MESSAGE_LENGTH];
+    generate_random_message(message, len);
+    uint8_t *padded;
+    size_t padded_len;
+    if (pad_message(message, len, &padded, &padded_len) < 0)
+    {
+        fprintf(stderr, "Message padding failed\n");
+        return;
+    }
+    uint64_t *cycles = malloc(ROTATION_MACS * sizeof(uint64_t));
+    uint64_t *window_cycles = malloc(ROTATION_MACS * sizeof(uint64_t));
+    if (!cycles || !window_cycles)
+    {
+        fprintf(stderr, "Memory allocation failed\n");
+        free(cycles);
+        free(window_cycles);
+        free(padded);
+        return;
+    }
+
+    for (int mode = 0; mode < num_modes; mode++)
+    {
+        keyset ks;
+        generate_random_message(key1, KEY_SIZE);
+        generate_random_message(key2, KEY_SIZE);
+        if (keyset_init(&ks, key1, key2, ROTATION_TABLE_BLOCKS, variant) != 0)
+        {
+            fprintf(stderr, "Key set initialization failed\n");
+            break;
+        }
+
+        // untimed warm-up so the first timed MACs do not pay for cold caches
+        for (int i = 0; i < ROTATION_WARMUP; i++)
+            keyset_mac(&ks, padded, padded_len, tag, 128, 0);
+
+        // MACs from keyset_rotate() until the epoch flip form the rotation window
+        int rotations = 0;
+        size_t window_macs = 0;
+        int in_window = 0;
+        unsigned int rotate_epoch = 0;
+        uint64_t start, end;
+        for (int i = 0; i < ROTATION_MACS; i++)
+        {
+            if (in_window && atomic_load(&ks.epoch) != rotate_epoch)
+                in_window = 0;
+            _mm_lfence();
+            start = __rdtsc();
+            if (mode > 0 && i > 0 && i % ROTATION_INTERVAL == 0)
+            {
+                // the expected keys only follow a rotation that was accepted
+                uint8_t next_key1[KEY_SIZE], next_key2[KEY_SIZE];
+                generate_random_message(next_key1, KEY_SIZE);
+                generate_random_message(next_key2, KEY_SIZE);
+                unsigned int epoch = atomic_load(&ks.epoch);
+                if (keyset_rotate(&ks, next_key1, next_key2) == 0)
+                {
+                    rotate_epoch = epoch;
+                    in_window = 1;
+                    memcpy(key1, next_key1, KEY_SIZE);
+                    memcpy(key2, next_key2, KEY_SIZE);
+                    rotations++;
+                }
+                if (mode == 1)
+                    keyset_wait(&ks);
+            }
+            keyset_mac(&ks, padded, padded_len, tag, 128, 0);
+            _mm_lfence();
+            end = __rdtsc();
+            cycles[i] = end - start;
+            if (in_window)
+                window_cycles[window_macs++] = cycles[i];
+        }
+
+        // the last rotation must be visible to new MACs
+        keyset_wait(&ks);
+        uint8_t expected[BLOCK_SIZE];
+        keyset_mac(&ks, padded, padded_len, tag, 128, 0);
+        elimac(key1, key2, padded, padded_len, expected, 128, 0, 0, 0, variant, NULL, NULL);
+        if (memcmp(tag, expected, BLOCK_SIZE) != 0)
+            fprintf(stderr, "Key set tag differs from elimac() after rotation (mode %s)\n", modes[mode]);
+        keyset_destroy(&ks);
+
+        qsort(cycles, ROTATION_MACS, sizeof(uint64_t), compare_cycles);
+        uint64_t p50 = cycles[ROTATION_MACS / 2];
+        uint64_t p99 = cycles[(size_t)(ROTATION_MACS * 0.99)];
+        uint64_t p999 = cycles[(size_t)(ROTATION_MACS * 0.999)];
+        uint64_t max = cycles[ROTATION_MACS - 1];
+
+        uint64_t window_p50 = 0, window_p99 = 0, window_max = 0;
+        if (window_macs > 0)
+        {
+            qsort(window_cycles, window_macs, sizeof(uint64_t), compare_cycles);
+            window_p50 = window_cycles[window_macs / 2];
+            window_p99 = window_cycles[(size_t)(window_macs * 0.99)];
+            window_max = window_cycles[window_macs - 1];
+        }
+
+        if (strcmp(output_format, "csv") == 0)
+        {
+            fprintf(output_file, "%s;%u;%d;%d;%d;%llu;%llu;%llu;%llu;%zu;%llu;%llu;%llu\n", modes[mode], len, ROTATION_TABLE_BLOCKS, variant,
+                    rotations, (unsigned long long)p50, (unsigned long long)p99, (unsigned long long)p999, (unsigned long long)max,
+                    window_macs, (unsigned long long)window_p50, (unsigned long long)window_p99, (unsigned long long)window_max);
+        }
+        else
+        {
+            fprintf(output_file, "Rotation: %s, Length: %u bytes, Table: %d blocks, Rotations: %d\n",
+                    modes[mode], len, ROTATION_TABLE_BLOCKS, rotations);
+            fprintf(output_file, "p50: %llu cycles, p99: %llu cycles, p99.9: %llu cycles, max: %llu cycles\n",
+                    (unsigned long long)p50, (unsigned long long)p99, (unsigned long long)p999, (unsigned long long)max);
+            fprintf(output_file, "Rotation window (%zu MACs): p50: %llu cycles, p99: %llu cycles, max: %llu cycles\n",
+                    window_macs, (unsigned long long)window_p50, (unsigned long long)window_p99, (unsigned long long)window_max);
+        }
+    }
+
+    free(cycles);
+    free(window_cycles);
+    free(padded);
+}
+
+void run_key_agile_benchmark(FILE *output_file, const char *output_format, int encoding)
+{
+    srand(SEED);
+    uint32_t lengths[] = {16, 64, 256, 1024, 4096};
+    int num_lengths = 5;
+    const char *methods[] = {"table", "aesni", "batch"};
+    int num_methods = 3;
+    int tag_bits = 128;
+
+    // every message gets its own key pair
+    uint8_t *keys1 = malloc(ITERATIONS * KEY_SIZE);
+    uint8_t *keys2 = malloc(ITERATIONS * KEY_SIZE);
+    uint8_t *tags = malloc(num_methods * ITERATIONS * BLOCK_SIZE);
+    if (!keys1 || !keys2 || !tags)
+    {
+        fprintf(stderr, "Memory allocation failed for keys\n");
+        free(keys1);
+        free(keys2);
+        free(tags);
+        return;
+    }
+    generate_random_message(keys1, ITERATIONS * KEY_SIZE);
+    generate_random_message(keys2, ITERATIONS * KEY_SIZE);
+
+    int start_encoding = (encoding == 4) ? 0 : encoding;
+    int end_encoding = (encoding == 4) ? 4 : encoding + 1;
+
+    for (int enc = start_encoding; enc < end_encoding; enc++)
+    {
+        for (int l = 0; l < num_lengths; l++)
+        {
+            uint32_t len = lengths[l];
+            uint8_t *message = malloc(len);
+            if (!message)
+            {
+                fprintf(stderr, "Memory allocation failed for message\n");
+                break;
+            }
+            generate_random_message(message, len);
+            uint8_t *padded;
+            size_t padded_len;
+            if (pad_message(message, len, &padded, &padded_len) < 0)
+            {
+                fprintf(stderr, "Message padding failed\n");
+                free(message);
+                break;
+            }
+
+            uint64_t cycles[3];
+            for (int m = 0; m < num_methods; m++)
+            {
+                uint8_t *method_tags = tags + m * ITERATIONS * BLOCK_SIZE;
+                uint64_t start, end;
+                _mm_lfence();
+                start = __rdtsc();
+                if (m == 0)
+                {
+                    // table-driven: three schedules per message, as elimac() used to do
+                    for (int i = 0; i < ITERATIONS; i++)
+                    {
+                        uint8_t rk7[KEY_SIZE * 8], rk4[KEY_SIZE * 5], rk10[KEY_SIZE * 11];
+                        aes_key_schedule_table(keys1 + i * KEY_SIZE, rk7, 7);
+                        aes_key_schedule_table(keys1 + i * KEY_SIZE, rk4, 4);
+                        aes_key_schedule_table(keys2 + i * KEY_SIZE, rk10, 10);
+                        elimac_expanded(rk7, rk4, rk10, padded, padded_len, method_tags + i * BLOCK_SIZE, tag_bits, 0, 0, 0, enc, NULL);
+                    }
+                }
+                else if (m == 1)
+                {
+                    // AES-NI: K1 expanded once for both the 7- and 4-round schedules
+                    for (int i = 0; i < ITERATIONS; i++)
+                    {
+                        uint8_t rk7[KEY_SIZE * 8], rk10[KEY_SIZE * 11];
+                        aes_key_schedule(keys1 + i * KEY_SIZE, rk7, 7);
+                        aes_key_schedule(keys2 + i * KEY_SIZE, rk10, 10);
+                        elimac_expanded(rk7, rk7, rk10, padded, padded_len, method_tags + i * BLOCK_SIZE, tag_bits, 0, 0, 0, enc, NULL);
+                    }
+                }
+                else
+                {
+                    // batch: KEY_BATCH_LANES keys expanded together, interleaved, then used while in L1
+                    uint8_t rk7[KEY_BATCH_LANES * KEY_SIZE * 8], rk10[KEY_BATCH_LANES * KEY_SIZE * 11];
+                    for (int i0 = 0; i0 < ITERATIONS; i0 += KEY_BATCH_LANES)
+                    {
+                        int lanes = (ITERATIONS - i0 < KEY_BATCH_LANES) ? ITERATIONS - i0 : KEY_BATCH_LANES;
+                        aes_key_schedule_batch(keys1 + i0 * KEY_SIZE, rk7, lanes, 7);
+                        aes_key_schedule_batch(keys2 + i0 * KEY_SIZE, rk10, lanes, 10);
+                        for (int i = 0; i < lanes; i++)
+                        {
+                            elimac_expanded(rk7 + i * KEY_SIZE * 8, rk7 + i * KEY_SIZE * 8, rk10 + i * KEY_SIZE * 11, padded, padded_len,
+                                            method_tags + (i0 + i) * BLOCK_SIZE, tag_bits, 0, 0, 0, enc, NULL);
+                        }
+                    }
+                }
+                _mm_lfence();
+                end = __rdtsc();
+                cycles[m] = end - start;
+            }
+
+            for (int m = 0; m < num_methods; m++)
+            {
+                int match = memcmp(tags, tags + m * ITERATIONS * BLOCK_SIZE, ITERATIONS * BLOCK_SIZE) == 0;
+                if (!match)
+                    fprintf(stderr, "Key-agile tags differ for method %s (length %u, encoding %d)\n", methods[m], len, enc);
+                double cycles_per_message = (double)cycles[m] / ITERATIONS;
+                if (strcmp(output_format, "csv") == 0)
+                {
+                    fprintf(output_file, "%s;%u;%d;%d;%.2f;%.2f;%d\n", methods[m], len, tag_bits, enc,
+                            cycles_per_message, cycles_per_message / len, match);
+                }
+                else
+                {
+                    fprintf(output_file, "Method: %s, Length: %u bytes, Encoding: %d, Cycles/message: %.2f, Cycles/byte: %.2f%s\n",
+                            methods[m], len, enc, cycles_per_message, cycles_per_message / len, match ? "" : " (TAG MISMATCH)");
+                }
+            }
+
+            free(padded);
+            free(message);
+        }
+    }
+
+    free(keys1);
+    free(keys2);
+    free(tags);
+}
+
 int main(int argc, char *argv[])
 {
     char *message = DEFAULT_MESSAGE;
@@ -252,6 +744,12 @@ int main(int argc, char *argv[])
     int parallel = 0;
     int run_test = 0;
     int run_single = 0;
+    int run_multi = 0;
+    int run_calibrate = 0;
+    int run_rotation = 0;
+    int run_key_agile = 0;
+    int auto_mode = 0;
+    int num_keys = DEFAULT_MULTI_KEYS;
     int encoding = 4;
     char *output_format = "csv"; // Default: CSV
 
@@ -265,6 +763,19 @@ int main(int argc, char *argv[])
         {
             run_single = 1;
         }
+        else if (strcmp(argv[i], "--multi-key") == 0)
+        {
+            run_multi = 1;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                num_keys = atoi(argv[++i]);
+                if (num_keys < 1 || num_keys > MAX_MULTI_KEYS)
+                {
+                    fprintf(stderr, "Invalid number of keys. Use 1 to %d.\n", MAX_MULTI_KEYS);
+                    return 1;
+                }
+            }
+        }
         else if (strcmp(argv[i], "--message") == 0 && i + 1 < argc)
         {
             message = argv[++i];
@@ -273,6 +784,22 @@ int main(int argc, char *argv[])
         {
             random_keys = 1;
         }
+        else if (strcmp(argv[i], "--calibrate") == 0)
+        {
+            run_calibrate = 1;
+        }
+        else if (strcmp(argv[i], "--rotation") == 0)
+        {
+            run_rotation = 1;
+        }
+        else if (strcmp(argv[i], "--key-agile") == 0)
+        {
+            run_key_agile = 1;
+        }
+        else if (strcmp(argv[i], "--auto") == 0)
+        {
+            auto_mode = 1;
+        }
         else if (strcmp(argv[i], "--precompute") == 0)
         {
             precompute = 1;
@@ -311,18 +838,53 @@ int main(int argc, char *argv[])
         else
         {
             fprintf(stderr, "Unknown argument: %s\n", argv[i]);
-            fprintf(stderr, "Usage: %s [--test | --run [--message <text>] [--random-keys] [--precompute] [--parallel] [--tag-bits <32|64|96|128>] [--encoding <0|1|2>] [--output-format <txt|csv>]]\n", argv[0]);
+            fprintf(stderr, "Usage: %s [--test | --multi-key [<K>] | --calibrate | --rotation | --key-agile | --run [--message <text>] [--random-keys] [--auto] [--precompute] [--parallel] [--tag-bits <32|64|96|128>] [--encoding <0|1|2>] [--output-format <txt|csv>]]\n", argv[0]);
             return 1;
         }
     }
 
-    if (run_test + run_single != 1)
+    if (run_test + run_single + run_multi + run_calibrate + run_rotation + run_key_agile != 1)
     {
-        fprintf(stderr, "Error: Specify exactly one of --test or --run\n");
+        fprintf(stderr, "Error: Specify exactly one of --test, --multi-key, --calibrate, --rotation, --key-agile or --run\n");
         return -1;
     }
 
-    char *output_file_name = strcmp(output_format, "txt") == 0 ? "out/elimac_results.txt" : "out/elimac_results.csv";
+    if (run_calibrate)
+    {
+        printf("Calibrating strategies on this host...\n");
+        srand(SEED);
+        if (tuner_calibrate(TUNER_PROFILE_PATH, stdout) != 0)
+        {
+            fprintf(stderr, "Calibration failed\n");
+            return -1;
+        }
+        printf("Profile written to %s\n", TUNER_PROFILE_PATH);
+        return 0;
+    }
+
+    if (auto_mode && !run_single)
+    {
+        fprintf(stderr, "Error: --auto is only valid with --run\n");
+        return -1;
+    }
+
+    if (auto_mode)
+    {
+        if (tuner_load(TUNER_PROFILE_PATH) != 0)
+            fprintf(stderr, "No profile at %s, using default strategy (run --calibrate first)\n", TUNER_PROFILE_PATH);
+        precompute = ELIMAC_AUTO;
+        parallel = ELIMAC_AUTO;
+    }
+
+    char *output_file_name;
+    if (run_multi)
+        output_file_name = strcmp(output_format, "txt") == 0 ? "out/elimac_multikey.txt" : "out/elimac_multikey.csv";
+    else if (run_rotation)
+        output_file_name = strcmp(output_format, "txt") == 0 ? "out/elimac_rotation.txt" : "out/elimac_rotation.csv";
+    else if (run_key_agile)
+        output_file_name = strcmp(output_format, "txt") == 0 ? "out/elimac_keyagile.txt" : "out/elimac_keyagile.csv";
+    else
+        output_file_name = strcmp(output_format, "txt") == 0 ? "out/elimac_results.txt" : "out/elimac_results.csv";
     FILE *output_file = fopen(output_file_name, "w");
     if (!output_file)
     {
@@ -330,8 +892,20 @@ int main(int argc, char *argv[])
         return -1;
     }
 
-    if (strcmp(output_format, "csv") == 0)
-        fprintf(output_file, "MessageLength;TagBits;Precompute;Parallel;RandomKeys;Encoding;TimePrecompute;Tag;TimeUs;CyclesPerByte\n");
+    if (strcmp(output_format, "csv") == 0 && run_multi)
+        fprintf(output_file, "MessageLength;NumKeys;TagBits;Encoding;SeparateCyclesPerByte;BatchCyclesPerByte;Speedup;TagsMatch\n");
+    else if (strcmp(output_format, "csv") == 0 && run_rotation)
+        fprintf(output_file, "Rotation;MessageLength;TableBlocks;Encoding;Rotations;P50Cycles;P99Cycles;P999Cycles;MaxCycles;WindowMacs;WindowP50Cycles;WindowP99Cycles;WindowMaxCycles\n");
+    else if (strcmp(output_format, "csv") == 0 && run_key_agile)
+        fprintf(output_file, "Method;MessageLength;TagBits;Encoding;CyclesPerMessage;CyclesPerByte;TagsMatch\n");
+    else if (strcmp(output_format, "csv") == 0)
+    {
+        fprintf(output_file, "MessageLength;TagBits;Precompute;Parallel;RandomKeys;Encoding;TimePrecompute;Tag;TimeUs;CyclesPerByte;Kernel");
+#ifdef ELIMAC_INSTRUMENT
+        fprintf(output_file, ";KeyScheduleCycles;HashHCycles;HashICycles;LastBlockCycles;FinalAesCycles;Threads;ThreadImbalance");
+#endif
+        fprintf(output_file, "\n");
+    }
 
     if (run_test)
     {
@@ -341,14 +915,33 @@ int main(int argc, char *argv[])
         printf("Encoding: %s\n", encoding == 0 ? "Naive" : (encoding == 1 ? "Compact" : "Both"));
         run_test_suite(output_file, output_format, encoding);
     }
+    else if (run_multi)
+    {
+        printf("Running multi-key benchmark...\n");
+        printf("Output format: %s\n", output_format);
+        printf("Keys: %d\n", num_keys);
+        run_multi_key_benchmark(output_file, output_format, num_keys, encoding);
+    }
+    else if (run_rotation)
+    {
+        printf("Running key rotation benchmark...\n");
+        printf("Output format: %s\n", output_format);
+        run_rotation_benchmark(output_file, output_format, encoding);
+    }
+    else if (run_key_agile)
+    {
+        printf("Running key-agile benchmark...\n");
+        printf("Output format: %s\n", output_format);
+        run_key_agile_benchmark(output_file, output_format, encoding);
+    }
     else
     {
         printf("Running single message test...\n");
         printf("Message: \"%s\"\n", message);
         printf("Random keys: %s\n", random_keys ? "Yes" : "No");
-        printf("Precompute: %s\n", precompute ? "Yes" : "No");
+        printf("Precompute: %s\n", precompute == ELIMAC_AUTO ? "Auto" : (precompute ? "Yes" : "No"));
         printf("Tag bits: %d\n", tag_bits);
-        printf("Parallel: %s\n", parallel ? "Yes" : "No");
+        printf("Parallel: %s\n", parallel == ELIMAC_AUTO ? "Auto" : (parallel ? "Yes" : "No"));
         printf("Encoding: %s\n", encoding == 0 ? "Naive" : (encoding == 1 ? "Compact" : "Both"));
         run_single_message(output_file, output_format, message, random_keys, precompute, tag_bits, parallel, encoding);
     }
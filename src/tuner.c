@@ -0,0 +1,183 @@
+#include "headers/tuner.h"
+#include "headers/elimac.h"
+#include "headers/elihash.h"
+#include "headers/utils.h"
+#include <x86intrin.h>
+
+static tuner_entry profile[TUNER_MAX_ENTRIES];
+static int profile_size = 0;
+
+// Average cycles of one elimac() call with the given strategy
+static double tuner_measure(const uint8_t *key1, const uint8_t *key2, const uint8_t *padded, size_t padded_len,
+                            int precompute, int parallel, const uint8_t *subkeys, uint8_t *round_keys_7, size_t max_blocks, int variant)
+{
+    uint8_t tag[BLOCK_SIZE];
+    size_t iterations = TUNER_BYTES_PER_RUN / padded_len;
+    if (iterations < TUNER_MIN_ITERATIONS)
+        iterations = TUNER_MIN_ITERATIONS;
+    if (iterations > TUNER_MAX_ITERATIONS)
+        iterations = TUNER_MAX_ITERATIONS;
+
+    // Warm-up run
+    if (elimac(key1, key2, padded, padded_len, tag, 128, precompute, max_blocks, parallel, variant, subkeys, precompute ? round_keys_7 : NULL) != 0)
+        return -1.0;
+
+    uint64_t start, end, total_cycles = 0;
+    for (size_t i = 0; i < iterations; i++)
+    {
+        _mm_lfence();
+        start = __rdtsc();
+        elimac(key1, key2, padded, padded_len, tag, 128, precompute, max_blocks, parallel, variant, subkeys, precompute ? round_keys_7 : NULL);
+        _mm_lfence();
+        end = __rdtsc();
+        total_cycles += (end - start);
+    }
+    return (double)total_cycles / iterations;
+}
+
+// Benchmark every strategy over a size grid and write the fastest one per encoding and size
+int tuner_calibrate(const char *path, FILE *log)
+{
+    static const size_t lengths[] = {16, 64, 256, 1024, 4096, 16384, 65536, 262144, 1048576};
+    int num_lengths = sizeof(lengths) / sizeof(lengths[0]);
+#ifdef _OPENMP
+    int max_parallel = 1;
+#else
+    int max_parallel = 0;
+#endif
+
+    uint8_t key1[KEY_SIZE], key2[KEY_SIZE];
+    generate_random_message(key1, KEY_SIZE);
+    generate_random_message(key2, KEY_SIZE);
+    uint8_t round_keys_7[KEY_SIZE * 8];
+    aes_key_schedule(key1, round_keys_7, 7);
+
+    FILE *fp = fopen(path, "w");
+    if (!fp)
+    {
+        fprintf(stderr, "Failed to open profile file %s\n", path);
+        return -1;
+    }
+    fprintf(fp, "Encoding;Blocks;Precompute;Parallel;CyclesPerByte\n");
+
+    profile_size = 0;
+    for (int l = 0; l < num_lengths; l++)
+    {
+        size_t len = lengths[l];
+        uint8_t *message = malloc(len);
+        if (!message)
+        {
+            fprintf(stderr, "Memory allocation failed for message\n");
+            fclose(fp);
+            return -1;
+        }
+        generate_random_message(message, len);
+
+        uint8_t *padded;
+        size_t padded_len;
+        if (pad_message(message, len, &padded, &padded_len) < 0)
+        {
+            free(message);
+            fclose(fp);
+            return -1;
+        }
+        size_t num_blocks = padded_len / BLOCK_SIZE;
+        size_t max_blocks = num_blocks;
+        uint8_t *subkeys = malloc(max_blocks * BLOCK_SIZE);
+        if (!subkeys)
+        {
+            fprintf(stderr, "Memory allocation failed\n");
+            free(padded);
+            free(message);
+            fclose(fp);
+            return -1;
+        }
+        for (int variant = 0; variant < TUNER_NUM_VARIANTS; variant++)
+        {
+            precompute_subkeys(subkeys, max_blocks, round_keys_7, variant);
+
+            tuner_entry best = {variant, num_blocks, 0, 0, -1.0};
+            for (int parallel = 0; parallel <= max_parallel; parallel++)
+            {
+                for (int precompute = 0; precompute < 2; precompute++)
+                {
+                    double cycles = tuner_measure(key1, key2, padded, padded_len, precompute, parallel,
+                                                  precompute ? subkeys : NULL, round_keys_7, precompute ? max_blocks : 0, variant);
+                    if (cycles < 0)
+                        continue;
+                    double cycles_per_byte = cycles / len;
+                    if (log)
+                        fprintf(log, "Encoding: %d, Length: %zu bytes, Precompute: %d, Parallel: %d, CyclesPerByte: %.2f\n",
+                                variant, len, precompute, parallel, cycles_per_byte);
+                    if (best.cycles_per_byte < 0 || cycles_per_byte < best.cycles_per_byte)
+                    {
+                        best.precompute = precompute;
+                        best.parallel = parallel;
+                        best.cycles_per_byte = cycles_per_byte;
+                    }
+                }
+            }
+
+            fprintf(fp, "%d;%zu;%d;%d;%.2f\n", best.variant, best.blocks, best.precompute, best.parallel, best.cycles_per_byte);
+            if (profile_size < TUNER_MAX_ENTRIES)
+                profile[profile_size++] = best;
+        }
+
+        free(subkeys);
+        free(padded);
+        free(message);
+    }
+
+    fclose(fp);
+    return 0;
+}
+
+int tuner_load(const char *path)
+{
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+        return -1;
+
+    // skip header
+    int c;
+    while ((c = fgetc(fp)) != EOF && c != '\n')
+        ;
+
+    profile_size = 0;
+    tuner_entry entry;
+    while (profile_size < TUNER_MAX_ENTRIES &&
+           fscanf(fp, "%d;%zu;%d;%d;%lf", &entry.variant, &entry.blocks, &entry.precompute, &entry.parallel, &entry.cycles_per_byte) == 5)
+    {
+        profile[profile_size++] = entry;
+    }
+    fclose(fp);
+    return profile_size > 0 ? 0 : -1;
+}
+
+// Pick the strategy measured for this encoding at the largest grid size not above num_blocks
+void tuner_select(size_t num_blocks, int variant, int *precompute, int *parallel)
+{
+    const tuner_entry *chosen = NULL;
+    for (int i = 0; i < profile_size; i++)
+    {
+        if (profile[i].variant != variant)
+            continue;
+        if (!chosen || profile[i].blocks <= num_blocks)
+            chosen = &profile[i];
+    }
+
+    if (!chosen)
+    {
+        // No profile for this encoding: precompute off, parallel only for long messages
+        if (*precompute == ELIMAC_AUTO)
+            *precompute = 0;
+        if (*parallel == ELIMAC_AUTO)
+            *parallel = num_blocks >= TUNER_DEFAULT_PARALLEL_BLOCKS;
+        return;
+    }
+
+    if (*precompute == ELIMAC_AUTO)
+        *precompute = chosen->precompute;
+    if (*parallel == ELIMAC_AUTO)
+        *parallel = chosen->parallel;
+}
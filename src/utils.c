@@ -35,7 +35,8 @@ static const uint8_t sbox[256] = {
     0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68,
     0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16};
 
-int aes_key_schedule(const uint8_t *key, uint8_t *round_keys, int rounds)
+// Byte-wise table-driven expansion (reference, not constant time)
+int aes_key_schedule_table(const uint8_t *key, uint8_t *round_keys, int rounds)
 {
     if (rounds < 4 || rounds > 10)
     {
@@ -68,6 +69,130 @@ int aes_key_schedule(const uint8_t *key, uint8_t *round_keys, int rounds)
     return 0;
 }
 
+// One AES-128 key expansion step. SubWord(RotWord(w3)) ^ rcon is computed with
+// pshufb + aesenclast (all four columns equal, so ShiftRows is a no-op): same
+// result as aeskeygenassist, but fully pipelined so interleaved lanes overlap
+static inline __m128i aes_expand_step(__m128i key, __m128i rcon)
+{
+    __m128i assist = _mm_aesenclast_si128(_mm_shuffle_epi8(key, _mm_set1_epi32(0x0c0f0e0d)), rcon);
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, assist);
+}
+
+// One expansion round for every lane
+#define AES_EXPAND_ROUND(r, rcon)                                                    \
+    if (rounds >= r)                                                                 \
+    {                                                                                \
+        for (size_t i = 0; i < lanes; i++)                                           \
+        {                                                                            \
+            k[i] = aes_expand_step(k[i], _mm_set1_epi32(rcon));                      \
+            _mm_storeu_si128((__m128i *)(round_keys + i * stride + r * 16), k[i]); \
+        }                                                                            \
+    }
+
+// Fully unrolled expansion of up to KEY_BATCH_LANES keys; inlined with constant
+// rounds and lanes so every round is straight-line code across the lanes
+static inline __attribute__((always_inline)) void aes_expand_lanes(__m128i *k, size_t lanes, uint8_t *round_keys,
+                                                                   size_t stride, int rounds)
+{
+    for (size_t i = 0; i < lanes; i++)
+        _mm_storeu_si128((__m128i *)(round_keys + i * stride), k[i]);
+    AES_EXPAND_ROUND(1, 0x01)
+    AES_EXPAND_ROUND(2, 0x02)
+    AES_EXPAND_ROUND(3, 0x04)
+    AES_EXPAND_ROUND(4, 0x08)
+    AES_EXPAND_ROUND(5, 0x10)
+    AES_EXPAND_ROUND(6, 0x20)
+    AES_EXPAND_ROUND(7, 0x40)
+    AES_EXPAND_ROUND(8, 0x80)
+    AES_EXPAND_ROUND(9, 0x1B)
+    AES_EXPAND_ROUND(10, 0x36)
+}
+
+// AES-NI expansion; the schedule for fewer rounds is a prefix of the longer one
+int aes_key_schedule(const uint8_t *key, uint8_t *round_keys, int rounds)
+{
+    if (rounds < 4 || rounds > 10)
+    {
+        fprintf(stderr, "Rounds must be between 4 and 10\n");
+        return -1;
+    }
+    if (!key || !round_keys)
+    {
+        fprintf(stderr, "Null pointer in key schedule\n");
+        return -1;
+    }
+    __m128i k = _mm_loadu_si128((const __m128i *)key);
+    switch (rounds)
+    {
+    case 4:
+        aes_expand_lanes(&k, 1, round_keys, 0, 4);
+        break;
+    case 7:
+        aes_expand_lanes(&k, 1, round_keys, 0, 7);
+        break;
+    case 10:
+        aes_expand_lanes(&k, 1, round_keys, 0, 10);
+        break;
+    default:
+        aes_expand_lanes(&k, 1, round_keys, 0, rounds);
+        break;
+    }
+    return 0;
+}
+
+static inline __attribute__((always_inline)) void aes_key_schedule_batch_rounds(const uint8_t *keys, uint8_t *round_keys,
+                                                                                size_t num_keys, int rounds)
+{
+    size_t stride = (size_t)(rounds + 1) * 16;
+    size_t k0 = 0;
+    __m128i k[KEY_BATCH_LANES];
+    for (; k0 + KEY_BATCH_LANES <= num_keys; k0 += KEY_BATCH_LANES)
+    {
+        for (size_t i = 0; i < KEY_BATCH_LANES; i++)
+            k[i] = _mm_loadu_si128((const __m128i *)(keys + (k0 + i) * KEY_SIZE));
+        aes_expand_lanes(k, KEY_BATCH_LANES, round_keys + k0 * stride, stride, rounds);
+    }
+    size_t lanes = num_keys - k0;
+    for (size_t i = 0; i < lanes; i++)
+        k[i] = _mm_loadu_si128((const __m128i *)(keys + (k0 + i) * KEY_SIZE));
+    aes_expand_lanes(k, lanes, round_keys + k0 * stride, stride, rounds);
+}
+
+// Expand num_keys keys (KEY_SIZE bytes each) into consecutive schedules of
+// (rounds + 1) round keys, interleaving KEY_BATCH_LANES keys per step
+int aes_key_schedule_batch(const uint8_t *keys, uint8_t *round_keys, size_t num_keys, int rounds)
+{
+    if (rounds < 4 || rounds > 10)
+    {
+        fprintf(stderr, "Rounds must be between 4 and 10\n");
+        return -1;
+    }
+    if (!keys || !round_keys)
+    {
+        fprintf(stderr, "Null pointer in key schedule\n");
+        return -1;
+    }
+    switch (rounds)
+    {
+    case 4:
+        aes_key_schedule_batch_rounds(keys, round_keys, num_keys, 4);
+        break;
+    case 7:
+        aes_key_schedule_batch_rounds(keys, round_keys, num_keys, 7);
+        break;
+    case 10:
+        aes_key_schedule_batch_rounds(keys, round_keys, num_keys, 10);
+        break;
+    default:
+        aes_key_schedule_batch_rounds(keys, round_keys, num_keys, rounds);
+        break;
+    }
+    return 0;
+}
+
 void aes_encrypt(const uint8_t *input, const uint8_t *round_keys, uint8_t *output, int rounds)
 {
     if (!input || !round_keys || !output)